@@ -0,0 +1,685 @@
+/**
+ * @file CCBasicThreadPool.h
+ * @author Charliechen114514 (chengh1922@mails.jlu.edu.cn)
+ * @brief   BasicThreadPool is the policy based thread pool, the queue,
+ *          the idle waits, the task storage and the stats are fixed
+ *          at compile time, see CCThreadPoolPolicies.h for the choices.
+ *          CCThreadPool is the default instantiation of it
+ * @version 0.1
+ * @date 2025-09-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+#include "CCThreadPoolConfig.h"
+#include "CCThreadPoolError.h"
+#include "CCThreadPoolLockProfiler.h"
+#include "CCThreadPoolPolicies.h"
+#include <atomic>
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+#include <iostream>
+#endif
+namespace CCThreadPool {
+
+namespace detail {
+	/**
+	 * @brief   inline_depth is how deep the calling thread is in inline
+	 *          runs, one counter shared by every pool of any policies, so
+	 *          the nesting across the pools is bounded as well
+	 *
+	 */
+	inline thread_local unsigned int inline_depth = 0;
+} // namespace detail
+
+template <class QueuePolicy = FifoQueuePolicy,
+          class IdlePolicy = BlockingIdlePolicy,
+          class TaskStorage = FunctionTaskStorage,
+          class StatsPolicy = NoStatsPolicy>
+class BasicThreadPool : private StatsPolicy {
+public:
+	BasicThreadPool(
+	    const std::unique_ptr<ThreadCountAccessibleProvider> provider
+	    = std::make_unique<ThreadCountDefaultProvider>());
+
+	~BasicThreadPool() {
+		shutdown_all();
+	}
+	template <class Funtor, class... RequestArguments>
+	using FutureWrapType = std::invoke_result_t<
+	    std::decay_t<Funtor>,
+	    std::decay_t<RequestArguments>...>;
+
+	template <class Funtor, class... RequestArguments>
+	auto enTask(Funtor&& functor, RequestArguments&&... requestArgs)
+	    -> std::future<FutureWrapType<Funtor, RequestArguments...>> {
+
+		using Result_t = FutureWrapType<Funtor, RequestArguments...>;
+		std::packaged_task<Result_t()> runnable_task(
+		    make_task_lambda(std::forward<Funtor>(functor),
+		                     std::forward<RequestArguments>(requestArgs)...));
+
+		std::future<Result_t> future = runnable_task.get_future();
+		// erase the type before locking, the allocations stay out of the lock
+		task_t task = TaskStorage::wrap(std::move(runnable_task));
+		bool run_inline = false;
+
+		{
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+			LockSiteScope site(LockSite::producer);
+#endif
+			std::unique_lock<pool_mutex_t> lk(tasks_queue_locker);
+			if (terminate_self.load(std::memory_order_relaxed))
+				throw ThreadPoolTerminateError();
+
+			run_inline = inline_when_saturated.load(std::memory_order_relaxed)
+			    && is_saturated_locked()
+			    && detail::inline_depth < max_inline_depth.load(std::memory_order_relaxed);
+			if (!run_inline)
+				push_task_locked(std::move(task));
+		}
+
+		StatsPolicy::on_submit();
+		if (run_inline) {
+			// caller runs: the workers are all busy, skip the round trip
+			run_inline_task(task);
+			return future;
+		}
+		wakeup_cond_var.notify_one(); // wake up one to finish the sessions
+		return future;
+	}
+
+	/**
+	 * @brief   enTask for the trivial tasks, the task is run at once on the
+	 *          submitting thread and the returned future is already ready.
+	 *          If the thread is max_inline_depth deep in inline runs, the
+	 *          task is queued instead
+	 *
+	 */
+	template <class Funtor, class... RequestArguments>
+	auto enTask(trivial_task_t, Funtor&& functor, RequestArguments&&... requestArgs)
+	    -> std::future<FutureWrapType<Funtor, RequestArguments...>> {
+		if (terminate_self.load(std::memory_order_relaxed))
+			throw ThreadPoolTerminateError();
+
+		if (detail::inline_depth >= max_inline_depth.load(std::memory_order_relaxed)) {
+			return enTask(std::forward<Funtor>(functor),
+			              std::forward<RequestArguments>(requestArgs)...);
+		}
+
+		using Result_t = FutureWrapType<Funtor, RequestArguments...>;
+		std::packaged_task<Result_t()> runnable_task(
+		    make_task_lambda(std::forward<Funtor>(functor),
+		                     std::forward<RequestArguments>(requestArgs)...));
+
+		std::future<Result_t> future = runnable_task.get_future();
+		StatsPolicy::on_submit();
+		run_inline_task(runnable_task);
+		return future;
+	}
+
+	/**
+	 * @brief Set the inline execution config, see InlineExecutionConfig
+	 * @exception   InlineExecutionConfigError means the saturation_queue_depth
+	 *              is 0
+	 *
+	 * @param config
+	 */
+	void set_inline_execution(const InlineExecutionConfig& config);
+
+	/**
+	 * @brief   resize_thread_count will resize the thread counts up!
+	 *          to be noticed: these shell throw exceptions
+	 * @exception   ThreadCountUnderflow means the resize count your refer
+	 *              to small
+	 *              ThreadCountOverflow  means the resize count your refer
+	 *              to large
+	 *
+	 * @param new_count the count of new
+	 */
+	void resize_thread_count(const unsigned int new_count);
+
+	/**
+	 * @brief Set the thread max count object
+	 *
+	 * @param cnt
+	 */
+	void set_thread_max_count(const unsigned int cnt);
+
+	/**
+	 * @brief Set the thread min count object
+	 *
+	 * @param cnt
+	 */
+	void set_thread_min_count(const unsigned int cnt);
+
+	/**
+	 * @brief   shutup, threads! The tasks already queued are still
+	 *          finished before the workers exit
+	 *
+	 */
+	void shutdown_all();
+
+	/**
+	 * @brief   thread_count tells how many workers the pool has started
+	 *
+	 * @return unsigned int
+	 */
+	unsigned int thread_count() const;
+
+	/**
+	 * @brief   lock_profile snapshots the contention of the pool lockers
+	 *          and the wakeups of the workers. Only counts when the
+	 *          library is built with CCTHREADPOOL_PROFILE_LOCKS, else
+	 *          an empty profile with enabled == false is returned.
+	 *          The profile is also reported to std::clog at shutdown_all,
+	 *          and still covers the released workers after it
+	 *
+	 * @return ThreadPoolLockProfile
+	 */
+	ThreadPoolLockProfile lock_profile() const;
+
+	/**
+	 * @brief   stats snapshots the counters of the StatsPolicy, with the
+	 *          NoStatsPolicy it is an empty struct
+	 *
+	 * @return StatsPolicy::snapshot_t
+	 */
+	typename StatsPolicy::snapshot_t stats() const {
+		return StatsPolicy::snapshot();
+	}
+
+private:
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+	using pool_mutex_t = ProfiledMutex;
+	using pool_cond_var_t = std::condition_variable_any;
+#else
+	using pool_mutex_t = std::mutex;
+	using pool_cond_var_t = std::condition_variable;
+#endif
+
+	using task_t = typename TaskStorage::task_t;
+	using task_queue_t = typename QueuePolicy::template queue<task_t>;
+
+	template <class Funtor, class... RequestArguments>
+	static auto make_task_lambda(Funtor&& functor, RequestArguments&&... requestArgs) {
+		return [functor = std::forward<Funtor>(functor),
+		        args_tuple = std::make_tuple(std::forward<RequestArguments>(requestArgs)...)]() mutable {
+			// std::apply invokes the captured functor with arguments
+			// from the tuple.
+			// 'mutable' is necessary in case the functor's
+			// operator() is not const.
+			// MoveOnly& for the args_tuple invoke
+			return std::apply(functor, std::move(args_tuple));
+		};
+	}
+
+	template <class Runnable>
+	void run_inline_task(Runnable& runnable) {
+		struct DepthGuard {
+			DepthGuard() { ++detail::inline_depth; }
+			~DepthGuard() { --detail::inline_depth; }
+		} guard;
+		runnable(); // the packaged_task keeps the exceptions in the future
+		StatsPolicy::on_execute();
+	}
+
+	/**
+	 * @brief   is_saturated_locked tells if no worker is waiting for the
+	 *          tasks and the backlog is deep, the batches parked in the
+	 *          local_tasks wait as well as the queue does. A batch counts
+	 *          whole until it is drained, so this may run inline a little
+	 *          early while the workers are working off their batches.
+	 *          Call with tasks_queue_locker held
+	 *
+	 */
+	bool is_saturated_locked() const noexcept {
+		return idle_workers == 0
+		    && cached_tasks.size() + stealable_tasks.load(std::memory_order_relaxed)
+		    >= saturation_queue_depth.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief   WorkerSlot is the per worker state, each one owns its
+	 *          cache line so the workers never write to the same line.
+	 *          local_tasks is the batch the worker took from the queue,
+	 *          the owner pops the front and idle peers steal the back
+	 *
+	 */
+	struct alignas(SHARED_STATE_ALIGNMENT) WorkerSlot {
+		std::thread worker; ///< the running thread
+		std::size_t steal_index { 0 }; ///< own place in steal_slots
+		std::mutex local_locker; ///< locker for the local_tasks
+		std::deque<task_t> local_tasks; ///< the batch waiting to be run
+		std::size_t parked_batch { 0 }; ///< what this batch adds to stealable_tasks, under local_locker
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+		std::atomic<uint64_t> wakeup_count { 0 }; ///< returns from the waits
+		std::atomic<uint64_t> spurious_wakeup_count { 0 }; ///< nothing to do wakeups
+#endif
+	};
+
+	/* ------------ Shared queue state, written by producers and consumers -------------- */
+	alignas(SHARED_STATE_ALIGNMENT) pool_mutex_t tasks_queue_locker; ///< locker for operating the queue
+	task_queue_t cached_tasks; ///< tasks queues
+	unsigned int idle_workers { 0 }; ///< workers waiting for the tasks
+	unsigned int running_workers { 0 }; ///< workers not exited yet
+
+	/* ------------ Lock free hints, read by the spinning workers -------------- */
+	alignas(SHARED_STATE_ALIGNMENT) std::atomic<std::size_t> stealable_tasks { 0 }; ///< the batches parked in the local_tasks, whole until drained
+	std::atomic<bool> queue_not_empty { false }; ///< mirrors !cached_tasks.empty()
+
+	/* ------------ Wakeups, notified by producers and waited by consumers -------------- */
+	alignas(SHARED_STATE_ALIGNMENT) pool_cond_var_t wakeup_cond_var; ///< controlling the wakeups
+
+	/* ------------ Read mostly, only written at configuring, resize or shutdown -------------- */
+	alignas(SHARED_STATE_ALIGNMENT) std::atomic<bool> terminate_self { false };
+	unsigned int thread_min_count; ///< configured by the package
+	unsigned int thread_max_count; ///< configured by the package
+	std::atomic<bool> inline_when_saturated {
+		InlineExecutionConfig {}.run_inline_when_saturated
+	}; ///< see InlineExecutionConfig
+	std::atomic<std::size_t> saturation_queue_depth {
+		InlineExecutionConfig {}.saturation_queue_depth
+	}; ///< see InlineExecutionConfig
+	std::atomic<unsigned int> max_inline_depth {
+		InlineExecutionConfig {}.max_inline_depth
+	}; ///< see InlineExecutionConfig
+
+	/* ------------ Read by the stealing workers without any locker -------------- */
+	alignas(SHARED_STATE_ALIGNMENT) std::unique_ptr<WorkerSlot*[]> steal_slots; ///< never reallocated, see the constructor
+	std::atomic<std::size_t> steal_slot_count { 0 }; ///< the published prefix of steal_slots
+	std::size_t steal_slot_capacity { 0 }; ///< fixed at constructing
+
+	/* ------------ Cold, only touched by the thread management -------------- */
+	alignas(SHARED_STATE_ALIGNMENT) mutable pool_mutex_t thread_workers_locker; ///< locker for operating the thread pool
+	std::vector<std::unique_ptr<WorkerSlot>> thread_workers; ///< workers for the thread
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+	uint64_t retired_wakeup_count { 0 }; ///< folded from the released slots
+	uint64_t retired_spurious_wakeup_count { 0 }; ///< folded from the released slots
+#endif
+
+private:
+	/* ------------ Disable the Default Implementations -------------- */
+	BasicThreadPool(const BasicThreadPool&) = delete;
+	BasicThreadPool& operator=(const BasicThreadPool&) = delete;
+
+	/* ------------ Some Helpers ------------ */
+	void start_worker(const unsigned int sz); ///< init the worker given by the
+
+	void worker_func(WorkerSlot* self);
+
+	/**
+	 * @brief   take_batch_locked moves a few more tasks of the queue into
+	 *          the local_tasks of self, about a fair share of the queue
+	 *          for each running worker and at most DEQUEUE_BATCH_MAX - 1.
+	 *          Call with tasks_queue_locker held
+	 *
+	 * @return how many tasks are moved
+	 */
+	std::size_t take_batch_locked(WorkerSlot* self);
+
+	/**
+	 * @brief   push_task_locked and pop_task_locked keep queue_not_empty
+	 *          in step with cached_tasks, it is only written when the
+	 *          queue turns empty or non empty. Call with tasks_queue_locker held
+	 *
+	 */
+	void push_task_locked(task_t&& task) {
+		cached_tasks.push(std::move(task));
+		if (!queue_not_empty.load(std::memory_order_relaxed))
+			queue_not_empty.store(true, std::memory_order_relaxed);
+	}
+	task_t pop_task_locked() {
+		task_t task = cached_tasks.pop();
+		if (cached_tasks.empty())
+			queue_not_empty.store(false, std::memory_order_relaxed);
+		return task;
+	}
+
+	bool pop_local_task(WorkerSlot* self, task_t& task);
+
+	/**
+	 * @brief   release_drained_batch takes the batch of slot out of
+	 *          stealable_tasks once its local_tasks is empty, so the shared
+	 *          counter is written per batch instead of per task.
+	 *          Call with the local_locker of slot held
+	 *
+	 */
+	void release_drained_batch(WorkerSlot* slot) noexcept {
+		if (!slot->local_tasks.empty())
+			return;
+		stealable_tasks.fetch_sub(slot->parked_batch, std::memory_order_relaxed);
+		slot->parked_batch = 0;
+	}
+	bool steal_task(WorkerSlot* self, task_t& task);
+}; // defines the BasicThreadPool
+
+/* ------------ Implementations -------------- */
+
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::BasicThreadPool(
+    const std::unique_ptr<ThreadCountAccessibleProvider> provider) {
+
+	const auto init_cnt = provider->getThreadInitCount();
+	thread_max_count = provider->getThreadMaxCount();
+	thread_min_count = provider->getThreadMinCount();
+
+	// the thieves walk steal_slots without a locker, so it never grows:
+	// the slots are never removed and resize_thread_count never adds
+	// past thread_max_count
+	steal_slot_capacity = std::max(init_cnt, thread_max_count);
+	steal_slots = std::make_unique<WorkerSlot*[]>(steal_slot_capacity);
+
+	start_worker(init_cnt);
+}
+
+// Resize thread pool to n threads (can be larger or smaller)
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+void BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::resize_thread_count(const unsigned int n) {
+	if (n < thread_min_count)
+		throw ThreadCountUnderflow(n, thread_min_count, thread_max_count);
+
+	if (n > thread_max_count)
+		throw ThreadCountOverflow(n, thread_min_count, thread_max_count);
+
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+	LockSiteScope site(LockSite::management); // a task may resize its pool
+#endif
+
+	std::unique_lock<pool_mutex_t> lk(thread_workers_locker);
+	size_t current = thread_workers.size();
+	if (n == current)
+		return; // We dont need to make threads
+	if (n > current) {
+		// add threads
+		auto adder = n - current;
+		lk.unlock();
+		start_worker(adder);
+	} else {
+		// reduce threads: enqueue exit tokens so that some workers exit
+		size_t remove_cnt = current - n;
+
+		{
+			std::unique_lock<pool_mutex_t> qlk(tasks_queue_locker);
+			for (size_t i = 0; i < remove_cnt; ++i) {
+				push_task_locked(TaskStorage::make_exit());
+			}
+		}
+
+		// wake up all to let them pick up exit tokens
+		wakeup_cond_var.notify_all();
+		return; // Clean at the close cast
+	}
+}
+
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+void BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::set_inline_execution(
+    const InlineExecutionConfig& config) {
+	if (config.saturation_queue_depth == 0)
+		throw InlineExecutionConfigError("saturation_queue_depth must be greater than 0");
+	inline_when_saturated.store(config.run_inline_when_saturated, std::memory_order_relaxed);
+	saturation_queue_depth.store(config.saturation_queue_depth, std::memory_order_relaxed);
+	max_inline_depth.store(config.max_inline_depth, std::memory_order_relaxed);
+}
+
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+void BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::start_worker(const unsigned int sz) {
+	std::unique_lock<pool_mutex_t> thread_locker(thread_workers_locker);
+	if (terminate_self.load(std::memory_order_relaxed))
+		return; // shutdown_all is joining, no more workers
+	for (unsigned int i = 0; i < sz && thread_workers.size() < steal_slot_capacity; i++) {
+		// for each tasks, we need to run the self functions
+		auto slot = std::make_unique<WorkerSlot>();
+		WorkerSlot* raw = slot.get();
+		raw->steal_index = thread_workers.size();
+		thread_workers.emplace_back(std::move(slot));
+		// published before the thread runs, so self is always among the
+		// slots it walks, the thieves load the count with acquire
+		steal_slots[raw->steal_index] = raw;
+		steal_slot_count.store(thread_workers.size(), std::memory_order_release);
+		raw->worker = std::thread(&BasicThreadPool::worker_func, this, raw);
+	}
+}
+
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+void BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::shutdown_all() {
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+	LockSiteScope site(LockSite::management);
+#endif
+	{
+		std::unique_lock<pool_mutex_t> _t(tasks_queue_locker);
+		if (terminate_self.load(std::memory_order_relaxed)) // already terminates
+			return;
+		// no exit tokens here: whatever the QueuePolicy order is, the
+		// workers drain the queue and leave once it is empty
+		terminate_self.store(true, std::memory_order_relaxed);
+	}
+
+	wakeup_cond_var.notify_all();
+	// join without holding the locker, the draining tasks may still
+	// ask for thread_count
+	std::vector<std::thread*> joining;
+	{
+		std::unique_lock<pool_mutex_t> _w(thread_workers_locker);
+		for (auto& slot : thread_workers)
+			joining.push_back(&slot->worker);
+	}
+	for (auto* worker : joining) {
+		if (worker->joinable())
+			worker->join();
+		// If the thread is cancelled, thats OK!
+		// As we have detached it :)
+	}
+
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+	// report before the slots carrying the wakeup counters are released
+	std::clog << "CCThreadPool lock profile at shutdown:\n"
+	          << lock_profile();
+#endif
+	std::unique_lock<pool_mutex_t> _w(thread_workers_locker);
+	steal_slot_count.store(0, std::memory_order_relaxed); // every thief is joined
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+	// keep the wakeups of the slots, lock_profile stays valid after shutdown
+	for (const auto& slot : thread_workers) {
+		retired_wakeup_count += slot->wakeup_count.load(std::memory_order_relaxed);
+		retired_spurious_wakeup_count += slot->spurious_wakeup_count.load(std::memory_order_relaxed);
+	}
+#endif
+	thread_workers.clear();
+}
+
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+unsigned int BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::thread_count() const {
+	std::unique_lock<pool_mutex_t> _w(thread_workers_locker);
+	return static_cast<unsigned int>(thread_workers.size());
+}
+
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+ThreadPoolLockProfile BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::lock_profile() const {
+	ThreadPoolLockProfile profile;
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+	profile.enabled = true;
+	profile.tasks_queue_locker = tasks_queue_locker.snapshot();
+	profile.tasks_queue_locker_enTask = tasks_queue_locker.snapshot(LockSite::producer);
+	profile.tasks_queue_locker_worker_func = tasks_queue_locker.snapshot(LockSite::consumer);
+	profile.tasks_queue_locker_management = tasks_queue_locker.snapshot(LockSite::management);
+	std::unique_lock<pool_mutex_t> _w(thread_workers_locker);
+	profile.wakeup_count = retired_wakeup_count;
+	profile.spurious_wakeup_count = retired_spurious_wakeup_count;
+	for (const auto& slot : thread_workers) {
+		profile.wakeup_count += slot->wakeup_count.load(std::memory_order_relaxed);
+		profile.spurious_wakeup_count += slot->spurious_wakeup_count.load(std::memory_order_relaxed);
+	}
+	_w.unlock();
+	profile.thread_workers_locker = thread_workers_locker.snapshot();
+#endif
+	return profile;
+}
+
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+std::size_t BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::take_batch_locked(WorkerSlot* self) {
+	const std::size_t share = cached_tasks.size() / std::max(running_workers, 1u);
+	const std::size_t batch = std::min<std::size_t>(share, DEQUEUE_BATCH_MAX - 1);
+	if (batch == 0)
+		return 0; // not enough to share, take one at a time
+
+	std::size_t moved = 0;
+	std::unique_lock<std::mutex> lk(self->local_locker);
+	while (moved < batch && !cached_tasks.empty()) {
+		task_t task = pop_task_locked();
+		if (TaskStorage::is_exit(task)) {
+			// the exit token is for whoever pops it next, not for our batch
+			push_task_locked(std::move(task));
+			break;
+		}
+		self->local_tasks.push_back(std::move(task));
+		moved++;
+	}
+	// still under tasks_queue_locker, so the idle predicate never misses it.
+	// Counted once per batch, the pops only give it back when it is drained
+	self->parked_batch += moved;
+	stealable_tasks.fetch_add(moved, std::memory_order_relaxed);
+	return moved;
+}
+
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+bool BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::pop_local_task(WorkerSlot* self, task_t& task) {
+	std::unique_lock<std::mutex> lk(self->local_locker);
+	if (self->local_tasks.empty())
+		return false;
+	task = std::move(self->local_tasks.front());
+	self->local_tasks.pop_front();
+	release_drained_batch(self);
+	return true;
+}
+
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+bool BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::steal_task(WorkerSlot* self, task_t& task) {
+	// start after self, so the thieves do not all line up at the first slot
+	const std::size_t count = steal_slot_count.load(std::memory_order_acquire);
+	for (std::size_t i = 1; i < count; i++) {
+		WorkerSlot* slot = steal_slots[(self->steal_index + i) % count];
+		std::unique_lock<std::mutex> lk(slot->local_locker);
+		if (slot->local_tasks.empty())
+			continue;
+		// the back is the one its owner would reach last
+		task = std::move(slot->local_tasks.back());
+		slot->local_tasks.pop_back();
+		release_drained_batch(slot);
+		return true;
+	}
+	return false;
+}
+
+template <class QueuePolicy, class IdlePolicy, class TaskStorage, class StatsPolicy>
+void BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, StatsPolicy>::worker_func(WorkerSlot* self) {
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+	// the whole thread is a consumer, the tasks submitting retag as producers
+	LockSiteScope site(LockSite::consumer);
+#endif
+	{
+		std::unique_lock<pool_mutex_t> _locker(tasks_queue_locker);
+		++running_workers;
+	}
+
+	task_t task_type;
+	while (1) {
+		// run the batch we took last time first, no shared locker needed
+		if (!pop_local_task(self, task_type)) {
+			// lock the code to see if
+			// 1. there are tasks availables, in the queue or in the peers
+			// 2. wakeup_cond_var will wake up the thread if tasks availables
+			// 3. then we should see if these is due to terminate_self
+			// 4. 	if terminate_self == true, then all thread pool should shut down
+			//		once the queue and the local_tasks are drained
+			bool notify_peers = false;
+			bool has_task = false;
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+			bool woke_up = false; ///< a wakeup is counted in this round
+#endif
+			{
+				std::unique_lock<pool_mutex_t> _locker(tasks_queue_locker);
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+				// the predicate runs once before the first sleep, every other
+				// run is a return from the wait, failed runs are spurious ones
+				bool first_check = true;
+#endif
+				++idle_workers;
+				IdlePolicy::wait(
+				    _locker,
+				    wakeup_cond_var,
+				    [&]() {
+					    const bool ready = terminate_self.load(std::memory_order_relaxed) || // indicate terminates
+					        !cached_tasks.empty() || // comes the new sessions
+					        stealable_tasks.load(std::memory_order_relaxed) > 0; // peers have backlog
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+					    if (!first_check) {
+						    woke_up = true;
+						    self->wakeup_count.fetch_add(1, std::memory_order_relaxed);
+						    if (!ready)
+							    self->spurious_wakeup_count.fetch_add(1, std::memory_order_relaxed);
+					    }
+					    first_check = false;
+#endif
+					    return ready;
+				    },
+				    [this]() {
+					    return queue_not_empty.load(std::memory_order_relaxed)
+					        || stealable_tasks.load(std::memory_order_relaxed) > 0
+					        || terminate_self.load(std::memory_order_relaxed);
+				    });
+				--idle_workers;
+
+				if (!cached_tasks.empty()) {
+					// get the task
+					task_type = pop_task_locked();
+					if (TaskStorage::is_exit(task_type)) {
+						// NULL, as we dont owns anything worth execute
+						// as this is the actual exit token
+						// we should never execute this
+						--running_workers;
+						break;
+					}
+					has_task = true;
+					// a batch parked behind our task must not go unseen by sleepers
+					notify_peers = take_batch_locked(self) > 0 && idle_workers > 0;
+				} else if (terminate_self.load(std::memory_order_relaxed)
+				           && stealable_tasks.load(std::memory_order_relaxed) == 0) {
+					--running_workers;
+					break;
+				}
+			}
+
+			if (notify_peers)
+				wakeup_cond_var.notify_one();
+
+			if (!has_task && !steal_task(self, task_type)) {
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+				// woke up for a backlog the peers took first
+				if (woke_up)
+					self->spurious_wakeup_count.fetch_add(1, std::memory_order_relaxed);
+#endif
+				continue; // the backlog is taken by others, wait again
+			}
+		}
+		// invoke the task
+		task_type(); // invoke the task
+		task_type = task_t(); // release the captures before sleeping
+		StatsPolicy::on_execute();
+	}
+}
+
+} // namespace CCThreadPool
@@ -0,0 +1,426 @@
+/**
+ * @file CCParallelAlgorithms.h
+ * @author Charliechen114514 (chengh1922@mails.jlu.edu.cn)
+ * @brief   parallel for_each, transform, inclusive/exclusive scan and
+ *          sort running on a given thread pool, for the toolchains
+ *          without std::execution::par. Every range must be random
+ *          access. Do not call them from a task of the same pool, the
+ *          caller blocks on the pieces it hands out
+ * @version 0.1
+ * @date 2025-09-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+#include "CCThreadPoolConfig.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+namespace CCThreadPool {
+namespace parallel {
+
+/**
+ * @brief   below SEQUENTIAL_THRESHOLD elements the std algorithm is
+ *          called directly, the pool round trip costs more than it saves
+ *
+ */
+inline constexpr std::size_t SEQUENTIAL_THRESHOLD = 1 << 15;
+
+/**
+ * @brief   MIN_CHUNK_SIZE is the smallest slice handed to one task
+ *
+ */
+inline constexpr std::size_t MIN_CHUNK_SIZE = 1 << 13;
+
+/**
+ * @brief   CHUNKS_PER_THREAD over decomposes the range a little, so one
+ *          slow slice does not hold all the others
+ *
+ */
+inline constexpr std::size_t CHUNKS_PER_THREAD = 4;
+
+/**
+ * @brief   CACHE_BLOCK_BYTES caps the input of one scan chunk at about a
+ *          private L2, the two passes of the scans then run window by
+ *          window and the second pass reads what the first one cached
+ *
+ */
+inline constexpr std::size_t CACHE_BLOCK_BYTES = 1 << 18;
+
+namespace detail {
+
+	/**
+	 * @brief   elements_before_line counts the elements from out to the
+	 *          next cache line boundary of its address, 0 when out is not
+	 *          a real reference or Value_t does not divide the line
+	 *
+	 */
+	template <class Value_t, class OutputIt>
+	std::size_t elements_before_line(OutputIt out) {
+		if constexpr (std::is_lvalue_reference_v<decltype(*out)> && CACHE_LINE_SIZE % sizeof(Value_t) == 0) {
+			const std::size_t offset = reinterpret_cast<std::uintptr_t>(std::addressof(*out)) % CACHE_LINE_SIZE;
+			if (offset % sizeof(Value_t) == 0)
+				return (CACHE_LINE_SIZE - offset) % CACHE_LINE_SIZE / sizeof(Value_t);
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief   make_partition slices [0, n) into chunks of the output
+	 *          starting at out. When the output is contiguous and the size
+	 *          of Value_t divides CACHE_LINE_SIZE, every inner bound falls
+	 *          on a cache line boundary of the actual addresses, so two
+	 *          tasks never write the same line. A non zero max_chunk_size
+	 *          adds chunks until none is longer than it, still no shorter
+	 *          than MIN_CHUNK_SIZE. Returns count + 1 bounds
+	 *
+	 */
+	template <class Value_t, class OutputIt>
+	std::vector<std::size_t> make_partition(const std::size_t n, const std::size_t threads, OutputIt out,
+	                                        const std::size_t max_chunk_size = 0) {
+		constexpr std::size_t line_elements = sizeof(Value_t) >= CACHE_LINE_SIZE
+		    ? 1
+		    : CACHE_LINE_SIZE / sizeof(Value_t);
+
+		std::size_t chunks = std::max<std::size_t>(1, threads * CHUNKS_PER_THREAD);
+		if (max_chunk_size > 0)
+			chunks = std::max(chunks, (n + max_chunk_size - 1) / max_chunk_size);
+		chunks = std::min(chunks, std::max<std::size_t>(1, n / MIN_CHUNK_SIZE));
+		std::size_t chunk_size = (n + chunks - 1) / chunks;
+		chunk_size = (chunk_size + line_elements - 1) / line_elements * line_elements;
+
+		// the first chunk ends on the last line boundary within chunk_size
+		const std::size_t head = elements_before_line<Value_t>(out);
+		const std::size_t first_bound = head == 0 ? chunk_size : chunk_size - line_elements + head;
+		std::vector<std::size_t> bounds { 0 };
+		for (std::size_t begin = first_bound; begin < n; begin += chunk_size)
+			bounds.push_back(begin);
+		bounds.push_back(n);
+		return bounds;
+	}
+
+	/**
+	 * @brief   run_chunks calls fn(0) ... fn(count - 1), fn(0) on the
+	 *          calling thread and the others on the pool, then waits for
+	 *          all of them and rethrows the first exception. If a submit
+	 *          throws, the tasks already submitted are still waited for
+	 *
+	 */
+	template <class Pool, class Function>
+	void run_chunks(Pool& pool, const std::size_t count, Function&& fn) {
+		std::vector<std::future<void>> futures;
+		std::exception_ptr error;
+		try {
+			futures.reserve(count);
+			for (std::size_t i = 1; i < count; i++)
+				futures.emplace_back(pool.enTask([&fn, i]() { fn(i); }));
+			if (count > 0)
+				fn(std::size_t { 0 });
+		} catch (...) {
+			error = std::current_exception();
+		}
+		// wait for every submitted task even on errors, they reference our stack
+		for (auto& f : futures) {
+			try {
+				f.get();
+			} catch (...) {
+				if (!error)
+					error = std::current_exception();
+			}
+		}
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	template <class Pool>
+	std::size_t thread_budget(const Pool& pool) {
+		return static_cast<std::size_t>(pool.thread_count()) + 1; // the caller joins
+	}
+
+	template <class Value_t>
+	constexpr std::size_t cache_block_size() {
+		return std::max<std::size_t>(1, CACHE_BLOCK_BYTES / sizeof(Value_t));
+	}
+
+	/**
+	 * @brief   fold_chunk reduces a non empty range without an identity,
+	 *          accumulating in Acc as the matching std scan does
+	 *
+	 */
+	template <class Acc, class InputIt, class BinaryOp>
+	Acc fold_chunk(InputIt first, InputIt last, BinaryOp op) {
+		Acc acc = *first;
+		for (++first; first != last; ++first)
+			acc = op(std::move(acc), *first);
+		return acc;
+	}
+
+	/**
+	 * @brief   merge_pieces merges the sorted [a_first, a_last) and
+	 *          [b_first, b_last) into out by moving, the larger run is cut
+	 *          into pieces and the matching cut of the other run is found
+	 *          by binary search, each piece is merged on its own task
+	 *
+	 */
+	template <class SrcIt, class DstIt, class Compare>
+	void merge_pieces(std::vector<std::function<void()>>& jobs,
+	                  SrcIt a_first, SrcIt a_last,
+	                  SrcIt b_first, SrcIt b_last,
+	                  DstIt out, Compare comp, const std::size_t pieces) {
+		const std::size_t a_size = static_cast<std::size_t>(a_last - a_first);
+		const std::size_t b_size = static_cast<std::size_t>(b_last - b_first);
+		const bool cut_a = a_size >= b_size;
+		const std::size_t big = cut_a ? a_size : b_size;
+		const std::size_t piece_count = std::max<std::size_t>(
+		    1, std::min(pieces, big / MIN_CHUNK_SIZE));
+
+		SrcIt a_begin = a_first;
+		SrcIt b_begin = b_first;
+		for (std::size_t p = 1; p <= piece_count; p++) {
+			SrcIt a_end = a_last;
+			SrcIt b_end = b_last;
+			if (p != piece_count) {
+				if (cut_a) {
+					a_end = a_first + big * p / piece_count;
+					// a goes first on ties, so b takes the ones strictly less
+					b_end = std::lower_bound(b_begin, b_last, *a_end, comp);
+				} else {
+					b_end = b_first + big * p / piece_count;
+					a_end = std::upper_bound(a_begin, a_last, *b_end, comp);
+				}
+			}
+			DstIt piece_out = out + ((a_begin - a_first) + (b_begin - b_first));
+			jobs.emplace_back([=]() {
+				std::merge(std::make_move_iterator(a_begin), std::make_move_iterator(a_end),
+				           std::make_move_iterator(b_begin), std::make_move_iterator(b_end),
+				           piece_out, comp);
+			});
+			a_begin = a_end;
+			b_begin = b_end;
+		}
+	}
+
+	/**
+	 * @brief   merge_round merges the neighbour runs of src given by
+	 *          bounds into dst, a run without a partner is moved as is.
+	 *          Returns the bounds of the merged runs
+	 *
+	 */
+	template <class Pool, class SrcIt, class DstIt, class Compare>
+	std::vector<std::size_t> merge_round(Pool& pool, SrcIt src, DstIt dst,
+	                                     const std::vector<std::size_t>& bounds,
+	                                     Compare comp, const std::size_t threads) {
+		const std::size_t runs = bounds.size() - 1;
+		const std::size_t pairs = (runs + 1) / 2;
+		const std::size_t pieces_per_pair = (threads + pairs - 1) / pairs;
+
+		std::vector<std::function<void()>> jobs;
+		std::vector<std::size_t> merged { 0 };
+		for (std::size_t r = 0; r < runs; r += 2) {
+			const std::size_t begin = bounds[r];
+			const std::size_t mid = bounds[r + 1];
+			const std::size_t end = r + 2 <= runs ? bounds[r + 2] : mid;
+			merge_pieces(jobs, src + begin, src + mid, src + mid, src + end,
+			             dst + begin, comp, pieces_per_pair);
+			merged.push_back(end);
+		}
+		run_chunks(pool, jobs.size(), [&jobs](const std::size_t i) { jobs[i](); });
+		return merged;
+	}
+
+} // namespace detail
+
+/**
+ * @brief   for_each calls f on every element of [first, last)
+ *
+ */
+template <class Pool, class RandomIt, class Function>
+void for_each(Pool& pool, RandomIt first, RandomIt last, Function f) {
+	using Value_t = typename std::iterator_traits<RandomIt>::value_type;
+	const std::size_t n = static_cast<std::size_t>(last - first);
+	if (n < SEQUENTIAL_THRESHOLD) {
+		std::for_each(first, last, f);
+		return;
+	}
+
+	const auto bounds = detail::make_partition<Value_t>(n, detail::thread_budget(pool), first);
+	detail::run_chunks(pool, bounds.size() - 1, [&](const std::size_t c) {
+		std::for_each(first + bounds[c], first + bounds[c + 1], f);
+	});
+}
+
+/**
+ * @brief   transform writes op(x) of every x in [first, last) to d_first
+ *
+ * @return the end of the written range
+ */
+template <class Pool, class RandomIt, class OutputIt, class UnaryOp>
+OutputIt transform(Pool& pool, RandomIt first, RandomIt last, OutputIt d_first, UnaryOp op) {
+	using Out_t = std::remove_reference_t<decltype(*d_first)>;
+	const std::size_t n = static_cast<std::size_t>(last - first);
+	if (n < SEQUENTIAL_THRESHOLD)
+		return std::transform(first, last, d_first, op);
+
+	// the output is the one written, so the blocks follow its elements
+	const auto bounds = detail::make_partition<Out_t>(n, detail::thread_budget(pool), d_first);
+	detail::run_chunks(pool, bounds.size() - 1, [&](const std::size_t c) {
+		std::transform(first + bounds[c], first + bounds[c + 1], d_first + bounds[c], op);
+	});
+	return d_first + n;
+}
+
+/**
+ * @brief   inclusive_scan writes the running op of [first, last) to
+ *          d_first, op must be associative. The chunks are at most
+ *          CACHE_BLOCK_BYTES of input and go in windows of one chunk per
+ *          thread: the window is reduced in parallel, its offsets are
+ *          scanned on the caller and it is scanned again in parallel
+ *          while its input is still in the caches
+ *
+ * @return the end of the written range
+ */
+template <class Pool, class RandomIt, class OutputIt, class BinaryOp = std::plus<>>
+OutputIt inclusive_scan(Pool& pool, RandomIt first, RandomIt last, OutputIt d_first, BinaryOp op = {}) {
+	using Value_t = typename std::iterator_traits<RandomIt>::value_type;
+	using Out_t = std::remove_reference_t<decltype(*d_first)>;
+	const std::size_t n = static_cast<std::size_t>(last - first);
+	if (n < SEQUENTIAL_THRESHOLD)
+		return std::inclusive_scan(first, last, d_first, op);
+
+	const std::size_t threads = detail::thread_budget(pool);
+	const auto bounds = detail::make_partition<Out_t>(n, threads, d_first, detail::cache_block_size<Value_t>());
+	const std::size_t chunks = bounds.size() - 1;
+
+	// sums[c] is op of every element up to the end of chunk c,
+	// the last chunk is never needed as an offset
+	std::vector<Value_t> sums(chunks);
+	for (std::size_t w = 0; w < chunks; w += threads) {
+		const std::size_t window = std::min(threads, chunks - w);
+		const std::size_t reduced = std::min(window, chunks - 1 - w);
+		detail::run_chunks(pool, reduced, [&](const std::size_t c) {
+			sums[w + c] = detail::fold_chunk<Value_t>(first + bounds[w + c], first + bounds[w + c + 1], op);
+		});
+		for (std::size_t c = std::max<std::size_t>(w, 1); c < w + reduced; c++)
+			sums[c] = op(sums[c - 1], sums[c]);
+
+		detail::run_chunks(pool, window, [&](const std::size_t c) {
+			const std::size_t k = w + c;
+			if (k == 0)
+				std::inclusive_scan(first + bounds[0], first + bounds[1], d_first, op);
+			else
+				std::inclusive_scan(first + bounds[k], first + bounds[k + 1],
+				                    d_first + bounds[k], op, sums[k - 1]);
+		});
+	}
+	return d_first + n;
+}
+
+/**
+ * @brief   exclusive_scan writes init op the elements before each one of
+ *          [first, last) to d_first, op must be associative. Blocked in
+ *          windows as inclusive_scan
+ *
+ * @return the end of the written range
+ */
+template <class Pool, class RandomIt, class OutputIt, class T, class BinaryOp = std::plus<>>
+OutputIt exclusive_scan(Pool& pool, RandomIt first, RandomIt last, OutputIt d_first, T init, BinaryOp op = {}) {
+	using Value_t = typename std::iterator_traits<RandomIt>::value_type;
+	using Out_t = std::remove_reference_t<decltype(*d_first)>;
+	const std::size_t n = static_cast<std::size_t>(last - first);
+	if (n < SEQUENTIAL_THRESHOLD)
+		return std::exclusive_scan(first, last, d_first, std::move(init), op);
+
+	const std::size_t threads = detail::thread_budget(pool);
+	const auto bounds = detail::make_partition<Out_t>(n, threads, d_first, detail::cache_block_size<Value_t>());
+	const std::size_t chunks = bounds.size() - 1;
+
+	// sums[c] is init op every element up to the end of chunk c, the sums
+	// are in T as std::exclusive_scan accumulates, a narrow Value_t would wrap
+	std::vector<T> sums(chunks, init);
+	for (std::size_t w = 0; w < chunks; w += threads) {
+		const std::size_t window = std::min(threads, chunks - w);
+		const std::size_t reduced = std::min(window, chunks - 1 - w);
+		detail::run_chunks(pool, reduced, [&](const std::size_t c) {
+			sums[w + c] = detail::fold_chunk<T>(first + bounds[w + c], first + bounds[w + c + 1], op);
+		});
+		for (std::size_t c = w; c < w + reduced; c++)
+			sums[c] = op(c == 0 ? init : sums[c - 1], sums[c]);
+
+		detail::run_chunks(pool, window, [&](const std::size_t c) {
+			const std::size_t k = w + c;
+			std::exclusive_scan(first + bounds[k], first + bounds[k + 1],
+			                    d_first + bounds[k], k == 0 ? init : sums[k - 1], op);
+		});
+	}
+	return d_first + n;
+}
+
+/**
+ * @brief   sort sorts [first, last) by comp, not stable. The chunks are
+ *          sorted by std::sort in parallel, then the neighbour runs are
+ *          merged round by round through a buffer, each merge is cut
+ *          into pieces so the last rounds still use every thread
+ *
+ */
+template <class Pool, class RandomIt, class Compare = std::less<>>
+void sort(Pool& pool, RandomIt first, RandomIt last, Compare comp = {}) {
+	using Value_t = typename std::iterator_traits<RandomIt>::value_type;
+	const std::size_t n = static_cast<std::size_t>(last - first);
+	if (n < SEQUENTIAL_THRESHOLD) {
+		std::sort(first, last, comp);
+		return;
+	}
+
+	const std::size_t threads = detail::thread_budget(pool);
+	auto bounds = detail::make_partition<Value_t>(n, threads, first);
+	detail::run_chunks(pool, bounds.size() - 1, [&](const std::size_t c) {
+		std::sort(first + bounds[c], first + bounds[c + 1], comp);
+	});
+	if (bounds.size() <= 2)
+		return; // a single chunk is already sorted
+
+	// the first round merges first into the buffer, so the buffer needs no
+	// copy of the range: new[] leaves trivial elements uninitialized and
+	// default constructs the others, only the types without a default
+	// constructor are moved into it on the caller
+	std::unique_ptr<Value_t[]> storage;
+	std::vector<Value_t> moved;
+	Value_t* buffer = nullptr;
+	bool sorted_in_buffer = false;
+	if constexpr (std::is_default_constructible_v<Value_t>) {
+		storage.reset(new Value_t[n]);
+		buffer = storage.get();
+	} else {
+		moved.assign(std::make_move_iterator(first), std::make_move_iterator(last));
+		buffer = moved.data();
+		sorted_in_buffer = true;
+	}
+
+	while (bounds.size() > 2) {
+		if (sorted_in_buffer)
+			bounds = detail::merge_round(pool, buffer, first, bounds, comp, threads);
+		else
+			bounds = detail::merge_round(pool, first, buffer, bounds, comp, threads);
+		sorted_in_buffer = !sorted_in_buffer;
+	}
+	if (sorted_in_buffer) {
+		const auto copy_bounds = detail::make_partition<Value_t>(n, threads, first);
+		detail::run_chunks(pool, copy_bounds.size() - 1, [&](const std::size_t c) {
+			std::move(buffer + copy_bounds[c], buffer + copy_bounds[c + 1],
+			          first + copy_bounds[c]);
+		});
+	}
+}
+
+} // namespace parallel
+} // namespace CCThreadPool
@@ -0,0 +1,107 @@
+/**
+ * @file CCThreadPoolConfig.h
+ * @author Charliechen114514 (chengh1922@mails.jlu.edu.cn)
+ * @brief   configurations shared by every thread pool instantiation,
+ *          the thread count providers and the cache line size
+ * @version 0.1
+ * @date 2025-09-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+#include <cstddef>
+namespace CCThreadPool {
+
+/**
+ * @brief   CACHE_LINE_SIZE is the alignment used to keep the hot fields
+ *          of the pool away from each other. It takes part in the layout
+ *          of CCThreadPool, so the library and the users must agree on it:
+ *          it is a fixed value instead of the compiler dependent
+ *          std::hardware_destructive_interference_size, override it by
+ *          the CCTHREADPOOL_CACHE_LINE_SIZE cmake cache variable
+ *
+ */
+#ifndef CCTHREADPOOL_CACHE_LINE_SIZE
+#define CCTHREADPOOL_CACHE_LINE_SIZE 64
+#endif
+inline constexpr std::size_t CACHE_LINE_SIZE = CCTHREADPOOL_CACHE_LINE_SIZE;
+static_assert((CACHE_LINE_SIZE & (CACHE_LINE_SIZE - 1)) == 0,
+              "CCTHREADPOOL_CACHE_LINE_SIZE must be a power of two");
+
+/**
+ * @brief   SHARED_STATE_ALIGNMENT is the alignment of the field groups
+ *          of the pool. CCTHREADPOOL_PACKED_LAYOUT drops it to the
+ *          fundamental alignment, which packs the groups together as the
+ *          baseline of the bench_shared_state benchmark, never ship it
+ *
+ */
+#ifdef CCTHREADPOOL_PACKED_LAYOUT
+inline constexpr std::size_t SHARED_STATE_ALIGNMENT = alignof(std::max_align_t);
+#else
+inline constexpr std::size_t SHARED_STATE_ALIGNMENT = CACHE_LINE_SIZE;
+#endif
+
+/**
+ * @brief   DEQUEUE_BATCH_MAX bounds how many tasks a worker takes from
+ *          the queue in one locking, the batch shrinks to the fair share
+ *          of each worker when the queue is short
+ *
+ */
+inline constexpr std::size_t DEQUEUE_BATCH_MAX = 16;
+
+/**
+ * @brief   ThreadCountAccessibleProvider provide how many thread
+ *          should we get for the configures count;
+ *			To override the behaviors of Provider, rewrite the provide*
+ *			API to adjust, see ThreadCountDefaultProvider as an example
+ *
+ */
+struct ThreadCountAccessibleProvider {
+	unsigned int getThreadInitCount() const; ///< interative interfaces
+	unsigned int getThreadMaxCount() const; ///< interative interfaces
+	unsigned int getThreadMinCount() const; ///< interative interfaces
+	virtual ~ThreadCountAccessibleProvider() = default;
+
+private:
+	virtual unsigned int provideThreadInitCount() const noexcept = 0;
+	virtual unsigned int provideThreadMaxCount() const noexcept = 0;
+	virtual unsigned int provideThreadMinCount() const noexcept = 0;
+}; // ThreadCountAccessibleProvider
+
+struct ThreadCountDefaultProvider : ThreadCountAccessibleProvider {
+	unsigned int provideThreadInitCount() const noexcept override;
+	unsigned int provideThreadMaxCount() const noexcept override;
+	unsigned int provideThreadMinCount() const noexcept override;
+};
+
+/**
+ * @brief   InlineExecutionConfig controls the caller-runs fast path of
+ *          enTask. When enabled and no worker is idle while at least
+ *          saturation_queue_depth tasks are waiting, the task is run on
+ *          the submitting thread and a ready future is returned.
+ *          max_inline_depth bounds the nested inline runs of one thread,
+ *          deeper submits are queued as usual to protect the stack.
+ *          saturation_queue_depth must be greater than 0, no idle worker
+ *          alone is briefly true whenever the workers are between tasks,
+ *          set_inline_execution throws InlineExecutionConfigError on 0
+ *
+ */
+struct InlineExecutionConfig {
+	bool run_inline_when_saturated { false }; ///< opt in, off by default
+	std::size_t saturation_queue_depth { 64 }; ///< waiting tasks to be saturated, > 0
+	unsigned int max_inline_depth { 8 }; ///< nested inline runs per thread
+};
+
+/**
+ * @brief   trivial_task marks the task as cheaper than a queue round
+ *          trip, enTask(trivial_task, f, args...) runs it inline
+ *          (still bounded by InlineExecutionConfig::max_inline_depth)
+ *
+ */
+struct trivial_task_t {
+	explicit trivial_task_t() = default;
+};
+inline constexpr trivial_task_t trivial_task {};
+
+} // namespace CCThreadPool
@@ -135,4 +135,11 @@ public:
 	}
 };
 
+class InlineExecutionConfigError : public std::invalid_argument {
+public:
+	explicit InlineExecutionConfigError(const std::string& reason)
+	    : std::invalid_argument("Invalid InlineExecutionConfig: " + reason) {
+	}
+};
+
 #undef EXCEPT_WHAT_SIGNATURE // Dont leak the defines
\ No newline at end of file
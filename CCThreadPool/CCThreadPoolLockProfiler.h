@@ -0,0 +1,217 @@
+/**
+ * @file CCThreadPoolLockProfiler.h
+ * @author Charliechen114514 (chengh1922@mails.jlu.edu.cn)
+ * @brief   Lock contention profiling helpers for CCThreadPool, the
+ *          instrumented mutex is only used when the library is built
+ *          with CCTHREADPOOL_PROFILE_LOCKS
+ * @version 0.1
+ * @date 2025-09-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+
+namespace CCThreadPool {
+
+/**
+ * @brief   LockProfile is a snapshot of a single instrumented mutex,
+ *          all the times are in nanoseconds
+ *
+ */
+struct LockProfile {
+	uint64_t acquire_count { 0 }; ///< how many times the lock is taken
+	uint64_t contended_count { 0 }; ///< how many times the lock is found held
+	uint64_t total_wait_ns { 0 }; ///< time spent blocking on a held lock
+	uint64_t max_wait_ns { 0 }; ///< the longest single blocking
+	uint64_t total_hold_ns { 0 }; ///< time spent owning the lock
+	uint64_t max_hold_ns { 0 }; ///< the longest single ownership
+};
+
+/**
+ * @brief   LockSite tells which side of the pool takes a locker, so the
+ *          producer contention and the consumer contention are told apart
+ *
+ */
+enum class LockSite : unsigned int {
+	management = 0, ///< resize, shutdown and the other calls, the default
+	producer, ///< enTask submitting the tasks
+	consumer, ///< worker_func taking the tasks
+};
+inline constexpr std::size_t LOCK_SITE_COUNT = 3;
+
+/**
+ * @brief   LockSiteScope tags the lockers taken by the current thread
+ *          with site until it is destroyed, the scopes nest. The waits of
+ *          the condition_variable_any relock under the same tag
+ *
+ */
+class LockSiteScope {
+public:
+	explicit LockSiteScope(const LockSite site) noexcept
+	    : saved(current_site) {
+		current_site = site;
+	}
+	~LockSiteScope() { current_site = saved; }
+	LockSiteScope(const LockSiteScope&) = delete;
+	LockSiteScope& operator=(const LockSiteScope&) = delete;
+
+	static LockSite current() noexcept { return current_site; }
+
+private:
+	LockSite saved;
+	static inline thread_local LockSite current_site = LockSite::management;
+};
+
+/**
+ * @brief   ThreadPoolLockProfile collects the profiles the pool cares
+ *          about, enabled tells if the library is built with the
+ *          CCTHREADPOOL_PROFILE_LOCKS, if not, every counter stays zero
+ *
+ */
+struct ThreadPoolLockProfile {
+	bool enabled { false };
+	LockProfile tasks_queue_locker; ///< profile of the task queue locker, every site
+	LockProfile tasks_queue_locker_enTask; ///< the part taken by enTask
+	LockProfile tasks_queue_locker_worker_func; ///< the part taken by worker_func
+	LockProfile tasks_queue_locker_management; ///< the part taken by resize and shutdown
+	LockProfile thread_workers_locker; ///< profile of the workers locker
+	uint64_t wakeup_count { 0 }; ///< worker returns from wakeup_cond_var
+	uint64_t spurious_wakeup_count { 0 }; ///< wakeups finding nothing to do
+};
+
+std::ostream& operator<<(std::ostream& os, const LockProfile& profile);
+std::ostream& operator<<(std::ostream& os, const ThreadPoolLockProfile& profile);
+
+/**
+ * @brief   ProfiledMutex is a drop-in replacement of std::mutex, which
+ *          records the acquire waits, the holds and the contentions, per
+ *          LockSite of the locking thread. As it is not a std::mutex,
+ *          pair it with std::condition_variable_any
+ *
+ */
+class ProfiledMutex {
+public:
+	ProfiledMutex() = default;
+	ProfiledMutex(const ProfiledMutex&) = delete;
+	ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+	void lock() {
+		Counters& site = counters[site_index()];
+		if (!raw_mutex.try_lock()) {
+			// the lock is held by others, time how long we block
+			const auto wait_start = clock_t::now();
+			raw_mutex.lock();
+			const uint64_t waited = elapsed_ns(wait_start);
+			site.contended_count.fetch_add(1, std::memory_order_relaxed);
+			site.total_wait_ns.fetch_add(waited, std::memory_order_relaxed);
+			update_max(site.max_wait_ns, waited);
+		}
+		on_acquired(site);
+	}
+
+	bool try_lock() {
+		Counters& site = counters[site_index()];
+		if (!raw_mutex.try_lock()) {
+			site.contended_count.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		on_acquired(site);
+		return true;
+	}
+
+	void unlock() {
+		// hold_start and hold_site are only touched by the owner, so read them before release
+		const uint64_t held = elapsed_ns(hold_start);
+		hold_site->total_hold_ns.fetch_add(held, std::memory_order_relaxed);
+		update_max(hold_site->max_hold_ns, held);
+		raw_mutex.unlock();
+	}
+
+	/**
+	 * @brief   snapshot of every site together
+	 *
+	 */
+	LockProfile snapshot() const {
+		LockProfile profile;
+		for (const auto& site : counters) {
+			const LockProfile part = site.snapshot();
+			profile.acquire_count += part.acquire_count;
+			profile.contended_count += part.contended_count;
+			profile.total_wait_ns += part.total_wait_ns;
+			profile.max_wait_ns = std::max(profile.max_wait_ns, part.max_wait_ns);
+			profile.total_hold_ns += part.total_hold_ns;
+			profile.max_hold_ns = std::max(profile.max_hold_ns, part.max_hold_ns);
+		}
+		return profile;
+	}
+
+	/**
+	 * @brief   snapshot of the acquisitions tagged with site
+	 *
+	 */
+	LockProfile snapshot(const LockSite site) const {
+		return counters[static_cast<std::size_t>(site)].snapshot();
+	}
+
+private:
+	using clock_t = std::chrono::steady_clock;
+
+	struct Counters {
+		std::atomic<uint64_t> acquire_count { 0 };
+		std::atomic<uint64_t> contended_count { 0 };
+		std::atomic<uint64_t> total_wait_ns { 0 };
+		std::atomic<uint64_t> max_wait_ns { 0 };
+		std::atomic<uint64_t> total_hold_ns { 0 };
+		std::atomic<uint64_t> max_hold_ns { 0 };
+
+		LockProfile snapshot() const {
+			LockProfile profile;
+			profile.acquire_count = acquire_count.load(std::memory_order_relaxed);
+			profile.contended_count = contended_count.load(std::memory_order_relaxed);
+			profile.total_wait_ns = total_wait_ns.load(std::memory_order_relaxed);
+			profile.max_wait_ns = max_wait_ns.load(std::memory_order_relaxed);
+			profile.total_hold_ns = total_hold_ns.load(std::memory_order_relaxed);
+			profile.max_hold_ns = max_hold_ns.load(std::memory_order_relaxed);
+			return profile;
+		}
+	};
+
+	static std::size_t site_index() noexcept {
+		return static_cast<std::size_t>(LockSiteScope::current());
+	}
+
+	static uint64_t elapsed_ns(const clock_t::time_point since) {
+		return static_cast<uint64_t>(
+		    std::chrono::duration_cast<std::chrono::nanoseconds>(
+		        clock_t::now() - since)
+		        .count());
+	}
+
+	static void update_max(std::atomic<uint64_t>& target, const uint64_t value) {
+		uint64_t current = target.load(std::memory_order_relaxed);
+		while (current < value
+		       && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) { }
+	}
+
+	void on_acquired(Counters& site) {
+		site.acquire_count.fetch_add(1, std::memory_order_relaxed);
+		hold_site = &site;
+		hold_start = clock_t::now();
+	}
+
+	std::mutex raw_mutex;
+	clock_t::time_point hold_start {}; ///< written by the owner only
+	Counters* hold_site { nullptr }; ///< written by the owner only
+
+	Counters counters[LOCK_SITE_COUNT];
+};
+
+} // namespace CCThreadPool
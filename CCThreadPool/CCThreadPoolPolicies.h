@@ -0,0 +1,266 @@
+/**
+ * @file CCThreadPoolPolicies.h
+ * @author Charliechen114514 (chengh1922@mails.jlu.edu.cn)
+ * @brief   compile time policies of BasicThreadPool, each one fixes a
+ *          choice of the pool so nothing is decided by virtual calls
+ *          on the hot path
+ * @version 0.1
+ * @date 2025-09-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+#include "CCThreadPoolConfig.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+namespace CCThreadPool {
+
+/* ------------ QueuePolicy: in which order the tasks are taken -------------- */
+
+/**
+ * @brief   FifoQueuePolicy takes the tasks in the submitting order
+ *
+ */
+struct FifoQueuePolicy {
+	template <class Task>
+	class queue {
+	public:
+		void push(Task&& task) { tasks.push_back(std::move(task)); }
+		Task pop() {
+			Task task = std::move(tasks.front());
+			tasks.pop_front();
+			return task;
+		}
+		bool empty() const noexcept { return tasks.empty(); }
+		std::size_t size() const noexcept { return tasks.size(); }
+
+	private:
+		std::deque<Task> tasks;
+	};
+};
+
+/**
+ * @brief   LifoQueuePolicy takes the latest submitted task first,
+ *          which keeps the hot data of the producer in cache
+ *
+ */
+struct LifoQueuePolicy {
+	template <class Task>
+	class queue {
+	public:
+		void push(Task&& task) { tasks.push_back(std::move(task)); }
+		Task pop() {
+			Task task = std::move(tasks.back());
+			tasks.pop_back();
+			return task;
+		}
+		bool empty() const noexcept { return tasks.empty(); }
+		std::size_t size() const noexcept { return tasks.size(); }
+
+	private:
+		std::vector<Task> tasks;
+	};
+};
+
+/* ------------ IdlePolicy: how the worker waits for the tasks -------------- */
+
+/**
+ * @brief   BlockingIdlePolicy sleeps on the condition variable at once.
+ *          Every IdlePolicy is called with the locker held, ready is the
+ *          predicate checked under the locker, may_have_work is a lock
+ *          free hint which may be read without it
+ *
+ */
+struct BlockingIdlePolicy {
+	template <class Lock, class CondVar, class Predicate, class Hint>
+	static void wait(Lock& lk, CondVar& cond_var, Predicate&& ready, Hint&&) {
+		cond_var.wait(lk, std::forward<Predicate>(ready));
+	}
+};
+
+/**
+ * @brief   SpinThenBlockIdlePolicy yields Spins times before sleeping,
+ *          it trades cpu for the wakeup latency of busy pools. The spin
+ *          only reads the may_have_work hint, the locker stays free for
+ *          the producers and is taken again to check ready before the
+ *          sleep. In the lock profile, that check counts as a wakeup
+ *
+ */
+template <unsigned int Spins = 64>
+struct SpinThenBlockIdlePolicy {
+	template <class Lock, class CondVar, class Predicate, class Hint>
+	static void wait(Lock& lk, CondVar& cond_var, Predicate&& ready, Hint&& may_have_work) {
+		if (ready())
+			return;
+		lk.unlock();
+		for (unsigned int i = 0; i < Spins && !may_have_work(); i++)
+			std::this_thread::yield();
+		lk.lock();
+		cond_var.wait(lk, std::forward<Predicate>(ready));
+	}
+};
+
+/* ------------ TaskStorage: how the submitted task is type erased -------------- */
+
+/**
+ * @brief   FunctionTaskStorage erases the tasks into std::function,
+ *          as std::function must be copyable, move-only callables
+ *          (such as std::packaged_task) are shared by a std::shared_ptr
+ *
+ */
+struct FunctionTaskStorage {
+	using task_t = std::function<void()>;
+
+	template <class Callable>
+	static task_t wrap(Callable&& callable) {
+		using Callable_t = std::decay_t<Callable>;
+		if constexpr (std::is_copy_constructible_v<Callable_t>) {
+			return task_t(std::forward<Callable>(callable));
+		} else {
+			auto shared = std::make_shared<Callable_t>(std::forward<Callable>(callable));
+			return task_t([shared]() { (*shared)(); });
+		}
+	}
+
+	static task_t make_exit() noexcept { return task_t(); }
+	static bool is_exit(const task_t& task) noexcept {
+		return !task; // NULL Functor
+	}
+};
+
+/**
+ * @brief   UniqueTask is a move-only void() callable, the callable is
+ *          held in one allocation and invoked by a plain function pointer
+ *
+ */
+class UniqueTask {
+public:
+	UniqueTask() noexcept = default;
+
+	template <class Callable,
+	          class = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, UniqueTask>>>
+	explicit UniqueTask(Callable&& callable)
+	    : storage(new std::decay_t<Callable>(std::forward<Callable>(callable)))
+	    , invoker(&invoke_callable<std::decay_t<Callable>>)
+	    , deleter(&delete_callable<std::decay_t<Callable>>) {
+	}
+
+	UniqueTask(UniqueTask&& other) noexcept
+	    : storage(std::exchange(other.storage, nullptr))
+	    , invoker(std::exchange(other.invoker, nullptr))
+	    , deleter(std::exchange(other.deleter, nullptr)) {
+	}
+
+	UniqueTask& operator=(UniqueTask&& other) noexcept {
+		if (this != &other) {
+			reset();
+			storage = std::exchange(other.storage, nullptr);
+			invoker = std::exchange(other.invoker, nullptr);
+			deleter = std::exchange(other.deleter, nullptr);
+		}
+		return *this;
+	}
+
+	UniqueTask(const UniqueTask&) = delete;
+	UniqueTask& operator=(const UniqueTask&) = delete;
+
+	~UniqueTask() { reset(); }
+
+	void operator()() { invoker(storage); }
+	explicit operator bool() const noexcept { return storage != nullptr; }
+
+private:
+	template <class Callable>
+	static void invoke_callable(void* callable) {
+		(*static_cast<Callable*>(callable))();
+	}
+
+	template <class Callable>
+	static void delete_callable(void* callable) noexcept {
+		delete static_cast<Callable*>(callable);
+	}
+
+	void reset() noexcept {
+		if (storage)
+			deleter(storage);
+		storage = nullptr;
+	}
+
+	void* storage { nullptr };
+	void (*invoker)(void*) { nullptr };
+	void (*deleter)(void*) noexcept { nullptr };
+};
+
+/**
+ * @brief   MoveOnlyTaskStorage erases the tasks into UniqueTask, which
+ *          saves the shared_ptr of FunctionTaskStorage for each task
+ *
+ */
+struct MoveOnlyTaskStorage {
+	using task_t = UniqueTask;
+
+	template <class Callable>
+	static task_t wrap(Callable&& callable) {
+		return task_t(std::forward<Callable>(callable));
+	}
+
+	static task_t make_exit() noexcept { return task_t(); }
+	static bool is_exit(const task_t& task) noexcept {
+		return !task; // Empty task
+	}
+};
+
+/* ------------ StatsPolicy: what the pool counts -------------- */
+
+/**
+ * @brief   NoStatsPolicy counts nothing, every hook is an empty inline
+ *          call and the pool inherits it for free as an empty base
+ *
+ */
+struct NoStatsPolicy {
+	struct snapshot_t { };
+
+	void on_submit() noexcept { }
+	void on_execute() noexcept { }
+	snapshot_t snapshot() const noexcept { return {}; }
+};
+
+/**
+ * @brief   CountingStatsPolicy counts the submitted and executed tasks,
+ *          the producer side and consumer side counters own their lines
+ *
+ */
+struct CountingStatsPolicy {
+	struct snapshot_t {
+		uint64_t submitted { 0 }; ///< tasks accepted by enTask
+		uint64_t executed { 0 }; ///< tasks finished by the workers
+	};
+
+	void on_submit() noexcept {
+		submitted.fetch_add(1, std::memory_order_relaxed);
+	}
+	void on_execute() noexcept {
+		executed.fetch_add(1, std::memory_order_relaxed);
+	}
+	snapshot_t snapshot() const noexcept {
+		snapshot_t snap;
+		snap.submitted = submitted.load(std::memory_order_relaxed);
+		snap.executed = executed.load(std::memory_order_relaxed);
+		return snap;
+	}
+
+private:
+	alignas(SHARED_STATE_ALIGNMENT) std::atomic<uint64_t> submitted { 0 };
+	alignas(SHARED_STATE_ALIGNMENT) std::atomic<uint64_t> executed { 0 };
+};
+
+} // namespace CCThreadPool
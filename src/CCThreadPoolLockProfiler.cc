@@ -0,0 +1,47 @@
+/**
+ * @file CCThreadPoolLockProfiler.cc
+ * @author Charliechen114514 (chengh1922@mails.jlu.edu.cn)
+ * @brief reporting utils of the lock contention profiles
+ * @version 0.1
+ * @date 2025-09-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "CCThreadPoolLockProfiler.h"
+#include <ostream>
+
+namespace CCThreadPool {
+
+std::ostream& operator<<(std::ostream& os, const LockProfile& profile) {
+	const uint64_t avg_wait = profile.contended_count
+	    ? profile.total_wait_ns / profile.contended_count
+	    : 0;
+	const uint64_t avg_hold = profile.acquire_count
+	    ? profile.total_hold_ns / profile.acquire_count
+	    : 0;
+	os << "acquires=" << profile.acquire_count
+	   << " contended=" << profile.contended_count
+	   << " wait(total/avg/max ns)=" << profile.total_wait_ns
+	   << "/" << avg_wait << "/" << profile.max_wait_ns
+	   << " hold(total/avg/max ns)=" << profile.total_hold_ns
+	   << "/" << avg_hold << "/" << profile.max_hold_ns;
+	return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const ThreadPoolLockProfile& profile) {
+	if (!profile.enabled) {
+		return os << "lock profiling disabled, "
+		             "build with CCTHREADPOOL_PROFILE_LOCKS=ON\n";
+	}
+	os << "tasks_queue_locker: " << profile.tasks_queue_locker << "\n"
+	   << "  by enTask: " << profile.tasks_queue_locker_enTask << "\n"
+	   << "  by worker_func: " << profile.tasks_queue_locker_worker_func << "\n"
+	   << "  by resize/shutdown: " << profile.tasks_queue_locker_management << "\n"
+	   << "thread_workers_locker: " << profile.thread_workers_locker << "\n"
+	   << "wakeups=" << profile.wakeup_count
+	   << " spurious=" << profile.spurious_wakeup_count << "\n";
+	return os;
+}
+
+} // namespace CCThreadPool
@@ -0,0 +1,99 @@
+#include "CCParallelAlgorithms.h"
+#include "CCThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// usage: bench_parallel_algorithms [n ...], defaults to 10^6 and 10^7,
+// pass 100000000 for the 10^8 run (needs about 2.5GB of memory)
+
+// small helper printing banner
+static void banner(const std::string& s) {
+	std::cout << "\n==== " << s << " ====\n";
+}
+
+template <class Function>
+static double time_it(Function&& f) {
+	auto start = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* name, double std_secs, double par_secs) {
+	std::cout << name << ": std=" << std_secs << "s parallel=" << par_secs
+	          << "s speedup=" << (std_secs / par_secs) << "x\n";
+}
+
+static void bench_size(CCThreadPool::CCThreadPool& pool, std::size_t n) {
+	banner("n=" + std::to_string(n) + " threads=" + std::to_string(pool.thread_count()));
+
+	std::mt19937_64 rng(20250925);
+	std::vector<int64_t> data(n);
+	for (auto& v : data)
+		v = static_cast<int64_t>(rng());
+
+	{
+		auto a = data;
+		auto b = data;
+		double std_secs = time_it([&]() { std::sort(a.begin(), a.end()); });
+		double par_secs = time_it([&]() { CCThreadPool::parallel::sort(pool, b.begin(), b.end()); });
+		if (a != b)
+			std::cerr << "sort mismatch!\n";
+		report("sort", std_secs, par_secs);
+	}
+
+	{
+		std::vector<int64_t> a(n), b(n);
+		double std_secs = time_it([&]() { std::inclusive_scan(data.begin(), data.end(), a.begin()); });
+		double par_secs = time_it([&]() {
+			CCThreadPool::parallel::inclusive_scan(pool, data.begin(), data.end(), b.begin());
+		});
+		if (a != b)
+			std::cerr << "inclusive_scan mismatch!\n";
+		report("inclusive_scan", std_secs, par_secs);
+
+		std_secs = time_it([&]() { std::exclusive_scan(data.begin(), data.end(), a.begin(), int64_t(0)); });
+		par_secs = time_it([&]() {
+			CCThreadPool::parallel::exclusive_scan(pool, data.begin(), data.end(), b.begin(), int64_t(0));
+		});
+		if (a != b)
+			std::cerr << "exclusive_scan mismatch!\n";
+		report("exclusive_scan", std_secs, par_secs);
+
+		auto op = [](int64_t v) { return (v ^ (v >> 7)) * 31; };
+		std_secs = time_it([&]() { std::transform(data.begin(), data.end(), a.begin(), op); });
+		par_secs = time_it([&]() {
+			CCThreadPool::parallel::transform(pool, data.begin(), data.end(), b.begin(), op);
+		});
+		if (a != b)
+			std::cerr << "transform mismatch!\n";
+		report("transform", std_secs, par_secs);
+
+		auto touch = [](int64_t& v) { v = v * 3 + 1; };
+		std_secs = time_it([&]() { std::for_each(a.begin(), a.end(), touch); });
+		par_secs = time_it([&]() { CCThreadPool::parallel::for_each(pool, b.begin(), b.end(), touch); });
+		if (a != b)
+			std::cerr << "for_each mismatch!\n";
+		report("for_each", std_secs, par_secs);
+	}
+}
+
+int main(int argc, char** argv) {
+	std::vector<std::size_t> sizes;
+	for (int i = 1; i < argc; ++i)
+		sizes.push_back(static_cast<std::size_t>(std::strtoull(argv[i], nullptr, 10)));
+	if (sizes.empty())
+		sizes = { 1000000, 10000000 };
+
+	CCThreadPool::CCThreadPool pool;
+	pool.resize_thread_count(std::thread::hardware_concurrency());
+	for (auto n : sizes)
+		bench_size(pool, n);
+	return 0;
+}
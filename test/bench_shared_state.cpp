@@ -0,0 +1,76 @@
+#include "CCThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// usage: bench_shared_state_padded [rounds] and bench_shared_state_packed [rounds]
+// both binaries run the same scenarios, the packed one is built with
+// CCTHREADPOOL_PACKED_LAYOUT, compare the TPS printed by the two runs
+
+using namespace std::chrono_literals;
+
+#ifdef CCTHREADPOOL_PACKED_LAYOUT
+static constexpr const char* LAYOUT_NAME = "packed";
+#else
+static constexpr const char* LAYOUT_NAME = "padded";
+#endif
+
+// small helper printing banner
+static void banner(const std::string& s) {
+	std::cout << "\n==== " << s << " ====\n";
+}
+
+// many producers flooding the queue while the workers drain it,
+// returns the seconds until every task is executed
+static double run_many_producers(const unsigned int producers, const unsigned int tasks_per_producer) {
+	CCThreadPool::CCThreadPool pool(std::make_unique<CCThreadPool::ThreadCountDefaultProvider>());
+
+	const uint64_t total = uint64_t(producers) * tasks_per_producer;
+	std::atomic<uint64_t> counter { 0 };
+	std::vector<std::thread> producers_v;
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int p = 0; p < producers; ++p) {
+		producers_v.emplace_back([&pool, &counter, tasks_per_producer]() {
+			for (unsigned int i = 0; i < tasks_per_producer; ++i) {
+				pool.enTask([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+			}
+		});
+	}
+	for (auto& t : producers_v)
+		t.join();
+
+	while (counter.load(std::memory_order_relaxed) < total)
+		std::this_thread::sleep_for(1ms);
+
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+	const int rounds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+	const unsigned int tasks_per_producer = 20000;
+
+	banner(std::string("layout=") + LAYOUT_NAME
+	       + " sizeof(CCThreadPool)=" + std::to_string(sizeof(CCThreadPool::CCThreadPool))
+	       + " hardware_concurrency=" + std::to_string(std::thread::hardware_concurrency()));
+
+	for (unsigned int producers : { 1u, 4u, 16u, 32u }) {
+		// the best round is the least disturbed by the rest of the machine
+		double best = 0;
+		for (int r = 0; r < rounds; r++) {
+			const double secs = run_many_producers(producers, tasks_per_producer);
+			best = (r == 0) ? secs : std::min(best, secs);
+		}
+		const uint64_t total = uint64_t(producers) * tasks_per_producer;
+		std::cout << LAYOUT_NAME << ": producers=" << producers << " tasks=" << total
+		          << " best=" << best << "s TPS=" << (total / best) << "\n";
+	}
+	return 0;
+}
@@ -1,14 +1,24 @@
+#include "CCParallelAlgorithms.h"
 #include "CCThreadPool.h"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <exception>
 #include <iostream>
+#include <numeric>
+#include <random>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 using namespace std::chrono_literals;
 
+// existing users forward declare the default pool
+namespace CCThreadPool {
+class CCThreadPool;
+}
+
 // small helper printing banner
 static void banner(const char* s) {
 	std::cout << "\n==== " << s << " ====\n";
@@ -41,6 +51,13 @@ struct MoveOnly {
 	int use() const { return *p; }
 };
 
+// fixed size pool, so the tests know how many workers to keep busy
+struct TwoThreadProvider : CCThreadPool::ThreadCountAccessibleProvider {
+	unsigned int provideThreadInitCount() const noexcept override { return 2; }
+	unsigned int provideThreadMaxCount() const noexcept override { return 4; }
+	unsigned int provideThreadMinCount() const noexcept override { return 1; }
+};
+
 // ---------- Tests ----------
 
 // 1) 基本接口测试：简单返回值、lambda、move-only、异常传播
@@ -213,6 +230,303 @@ void perf_test_vary_tasks_and_threads() {
 	std::cout << "perf_test done\n";
 }
 
+// 8) policy based pool: every policy swapped, stats counted, queue drained at shutdown
+void test_policy_pool() {
+	banner("policy_pool");
+	using namespace CCThreadPool;
+	using PolicyPool = BasicThreadPool<
+	    LifoQueuePolicy,
+	    SpinThenBlockIdlePolicy<>,
+	    MoveOnlyTaskStorage,
+	    CountingStatsPolicy>;
+	static_assert(std::is_empty_v<NoStatsPolicy>, "no stats should cost nothing");
+	static_assert(std::is_base_of_v<BasicThreadPool<>, CCThreadPool::CCThreadPool>,
+	              "CCThreadPool is the default instantiation");
+	static_assert(std::has_virtual_destructor_v<CCThreadPool::CCThreadPool>,
+	              "existing users may delete through CCThreadPool*");
+
+	std::atomic<int> completed { 0 };
+	const int total = 10000;
+	{
+		PolicyPool pool(std::make_unique<ThreadCountDefaultProvider>());
+
+		auto f1 = pool.enTask([](MoveOnly m) -> int { return m.use(); }, MoveOnly(7));
+		ASSERT_EQ(f1.get(), 7, "move-only result");
+
+		for (int i = 0; i < total; ++i)
+			pool.enTask([&completed]() { completed.fetch_add(1, std::memory_order_relaxed); });
+
+		pool.shutdown_all(); // lifo order must still drain every queued task
+		const auto snap = pool.stats();
+		ASSERT_EQ(snap.submitted, uint64_t(total + 1), "submitted count");
+		ASSERT_EQ(snap.executed, uint64_t(total + 1), "executed count");
+	}
+	ASSERT_EQ(completed.load(), total, "all tasks executed before shutdown returns");
+
+	std::cout << "policy_pool passed\n";
+}
+
+// 9) inline execution: trivial tasks, saturated pools and the depth guard
+void test_inline_execution() {
+	banner("inline_execution");
+	CCThreadPool::CCThreadPool pool(std::make_unique<TwoThreadProvider>());
+	const auto caller = std::this_thread::get_id();
+
+	// trivial tasks run on the caller and come back ready
+	auto f1 = pool.enTask(CCThreadPool::trivial_task, []() { return std::this_thread::get_id(); });
+	ASSERT_TRUE(f1.wait_for(0s) == std::future_status::ready, "trivial future is ready");
+	ASSERT_TRUE(f1.get() == caller, "trivial task runs on the caller");
+
+	auto f2 = pool.enTask(CCThreadPool::trivial_task, []() { throw std::runtime_error("inline boom"); return 1; });
+	bool threw = false;
+	try {
+		(void)f2.get();
+	} catch (const std::exception&) {
+		threw = true;
+	}
+	ASSERT_TRUE(threw, "inline exception propagated");
+
+	// nested trivial submits fall back to the queue past max_inline_depth,
+	// the depth is counted per thread across the pools of any policies
+	CCThreadPool::BasicThreadPool<CCThreadPool::LifoQueuePolicy> other(std::make_unique<TwoThreadProvider>());
+	CCThreadPool::InlineExecutionConfig config;
+	config.max_inline_depth = 2;
+	pool.set_inline_execution(config);
+	other.set_inline_execution(config);
+	std::atomic<unsigned int> inline_runs { 0 };
+	std::function<void(unsigned int)> nest = [&](unsigned int level) {
+		if (std::this_thread::get_id() == caller)
+			inline_runs.fetch_add(1);
+		if (level == 0)
+			return;
+		if (level % 2)
+			other.enTask(CCThreadPool::trivial_task, nest, level - 1).get();
+		else
+			pool.enTask(CCThreadPool::trivial_task, nest, level - 1).get();
+	};
+	pool.enTask(CCThreadPool::trivial_task, nest, 5u).get();
+	ASSERT_EQ(inline_runs.load(), 2u, "inline depth is bounded");
+
+	// saturated pool: both workers blocked, the next task runs inline
+	std::promise<void> gate;
+	std::shared_future<void> opened = gate.get_future().share();
+	std::atomic<int> started { 0 };
+	std::vector<std::future<void>> blockers;
+	for (int i = 0; i < 2; ++i) {
+		blockers.emplace_back(pool.enTask([&started, opened]() {
+			started.fetch_add(1);
+			opened.wait();
+		}));
+	}
+	while (started.load() < 2)
+		std::this_thread::sleep_for(1ms);
+
+	// a zero depth would call the pool saturated between any two tasks
+	config.run_inline_when_saturated = true;
+	config.saturation_queue_depth = 0;
+	threw = false;
+	try {
+		pool.set_inline_execution(config);
+	} catch (const InlineExecutionConfigError&) {
+		threw = true;
+	}
+	ASSERT_TRUE(threw, "zero saturation_queue_depth rejected");
+
+	// one task waits behind the blockers, turned on only now, else the
+	// blockers themselves could run inline
+	auto filler = pool.enTask([]() { });
+	config.saturation_queue_depth = 1;
+	pool.set_inline_execution(config);
+	auto f3 = pool.enTask([]() { return std::this_thread::get_id(); });
+	ASSERT_TRUE(f3.wait_for(0s) == std::future_status::ready, "saturated future is ready");
+	ASSERT_TRUE(f3.get() == caller, "saturated task runs on the caller");
+
+	gate.set_value();
+	for (auto& f : blockers)
+		f.get();
+	filler.get();
+
+	std::cout << "inline_execution passed\n";
+}
+
+// 10) parallel algorithms: compare against the std ones, above and below the threshold
+void test_parallel_algorithms() {
+	banner("parallel_algorithms");
+	CCThreadPool::CCThreadPool pool(std::make_unique<CCThreadPool::ThreadCountDefaultProvider>());
+	std::mt19937_64 rng(20250925);
+
+	for (std::size_t n : { std::size_t(1000), std::size_t(1) << 20, (std::size_t(1) << 20) + 12345 }) {
+		std::vector<int64_t> data(n);
+		for (auto& v : data)
+			v = static_cast<int64_t>(rng() % 1000000) - 500000;
+
+		// sort
+		auto sorted = data;
+		auto expected = data;
+		CCThreadPool::parallel::sort(pool, sorted.begin(), sorted.end());
+		std::sort(expected.begin(), expected.end());
+		ASSERT_TRUE(sorted == expected, "parallel sort");
+
+		CCThreadPool::parallel::sort(pool, sorted.begin(), sorted.end(), std::greater<>());
+		ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), std::greater<>()), "parallel sort by comp");
+
+		// scans
+		std::vector<int64_t> scanned(n), expected_scan(n);
+		CCThreadPool::parallel::inclusive_scan(pool, data.begin(), data.end(), scanned.begin());
+		std::inclusive_scan(data.begin(), data.end(), expected_scan.begin());
+		ASSERT_TRUE(scanned == expected_scan, "parallel inclusive_scan");
+
+		CCThreadPool::parallel::exclusive_scan(pool, data.begin(), data.end(), scanned.begin(), int64_t(7));
+		std::exclusive_scan(data.begin(), data.end(), expected_scan.begin(), int64_t(7));
+		ASSERT_TRUE(scanned == expected_scan, "parallel exclusive_scan");
+
+		// in place scan
+		auto in_place = data;
+		CCThreadPool::parallel::inclusive_scan(pool, in_place.begin(), in_place.end(), in_place.begin());
+		std::inclusive_scan(data.begin(), data.end(), expected_scan.begin());
+		ASSERT_TRUE(in_place == expected_scan, "parallel in place inclusive_scan");
+
+		// transform & for_each
+		std::vector<double> halves(n);
+		auto end = CCThreadPool::parallel::transform(pool, data.begin(), data.end(), halves.begin(),
+		                                             [](int64_t v) { return v / 2.0; });
+		ASSERT_TRUE(end == halves.end(), "transform returns the end");
+		for (std::size_t i = 0; i < n; ++i)
+			ASSERT_TRUE(halves[i] == data[i] / 2.0, "parallel transform");
+
+		std::atomic<int64_t> sum { 0 };
+		CCThreadPool::parallel::for_each(pool, data.begin(), data.end(),
+		                                 [&sum](int64_t v) { sum.fetch_add(v, std::memory_order_relaxed); });
+		ASSERT_EQ(sum.load(), std::accumulate(data.begin(), data.end(), int64_t(0)), "parallel for_each");
+	}
+
+	// mixed types: narrow elements scanned into a wide accumulator
+	std::vector<uint8_t> ones(std::size_t(1) << 20, 1);
+	std::vector<uint64_t> wide(ones.size()), expected_wide(ones.size());
+	CCThreadPool::parallel::exclusive_scan(pool, ones.begin(), ones.end(), wide.begin(), uint64_t(0));
+	std::exclusive_scan(ones.begin(), ones.end(), expected_wide.begin(), uint64_t(0));
+	ASSERT_TRUE(wide == expected_wide, "parallel exclusive_scan into a wider init type");
+	ASSERT_EQ(wide.back(), uint64_t(ones.size() - 1), "no wrap in the chunk sums");
+
+	// sort buffers: default constructed strings, moved copies without a default constructor
+	struct Keyed {
+		explicit Keyed(int64_t k)
+		    : key(k) { }
+		int64_t key;
+	};
+	std::vector<std::string> words;
+	std::vector<Keyed> keyed;
+	for (std::size_t i = 0; i < (std::size_t(1) << 17); ++i) {
+		words.push_back(std::to_string(rng()));
+		keyed.emplace_back(static_cast<int64_t>(rng() % 1000));
+	}
+	CCThreadPool::parallel::sort(pool, words.begin(), words.end());
+	ASSERT_TRUE(std::is_sorted(words.begin(), words.end()), "parallel sort of strings");
+	const auto by_key = [](const Keyed& a, const Keyed& b) { return a.key < b.key; };
+	CCThreadPool::parallel::sort(pool, keyed.begin(), keyed.end(), by_key);
+	ASSERT_TRUE(std::is_sorted(keyed.begin(), keyed.end(), by_key), "parallel sort without default constructor");
+
+	// the chunk bounds follow the cache lines of the output addresses
+	std::vector<int32_t> misaligned((std::size_t(1) << 20) + 64);
+	for (std::size_t skew = 0; skew < 16; ++skew) {
+		int32_t* out = misaligned.data() + skew;
+		const auto bounds = CCThreadPool::parallel::detail::make_partition<int32_t>(std::size_t(1) << 20, 4, out);
+		for (std::size_t c = 1; c + 1 < bounds.size(); ++c)
+			ASSERT_EQ(reinterpret_cast<std::uintptr_t>(out + bounds[c]) % CCThreadPool::CACHE_LINE_SIZE,
+			          std::uintptr_t(0), "chunk bound on a cache line");
+	}
+
+	// a chunk cap splits the range beyond the thread count
+	{
+		const std::size_t cap = CCThreadPool::parallel::detail::cache_block_size<int64_t>();
+		int64_t out = 0; // only its address is looked at
+		const auto bounds = CCThreadPool::parallel::detail::make_partition<int64_t>(cap * 40, 2, &out, cap);
+		for (std::size_t c = 0; c + 1 < bounds.size(); ++c)
+			ASSERT_TRUE(bounds[c + 1] - bounds[c] <= cap, "chunk within the cache block");
+	}
+
+	// exceptions from a chunk reach the caller
+	std::vector<int> big(std::size_t(1) << 20, 1);
+	big.back() = 0;
+	bool threw = false;
+	try {
+		CCThreadPool::parallel::for_each(pool, big.begin(), big.end(), [](int v) {
+			if (v == 0)
+				throw std::runtime_error("chunk boom");
+		});
+	} catch (const std::exception&) {
+		threw = true;
+	}
+	ASSERT_TRUE(threw, "chunk exception propagated");
+
+	// a submit refused by the pool reaches the caller
+	CCThreadPool::CCThreadPool stopped(std::make_unique<TwoThreadProvider>());
+	stopped.shutdown_all();
+	threw = false;
+	try {
+		CCThreadPool::parallel::for_each(stopped, big.begin(), big.end(), [](int) { });
+	} catch (...) {
+		threw = true;
+	}
+	ASSERT_TRUE(threw, "submit error propagated");
+
+	std::cout << "parallel_algorithms passed\n";
+}
+
+// 11) batched dequeue: a batch parked behind a long task is stolen by the idle peer,
+//     and still counts toward the saturation of the inline execution
+void test_batch_stealing() {
+	banner("batch_stealing");
+	CCThreadPool::CCThreadPool pool(std::make_unique<TwoThreadProvider>());
+
+	// park both workers
+	std::promise<void> gate_first, gate_second, gate_long;
+	std::shared_future<void> first = gate_first.get_future().share();
+	std::shared_future<void> second = gate_second.get_future().share();
+	std::shared_future<void> long_one = gate_long.get_future().share();
+	std::atomic<int> started { 0 };
+	auto b1 = pool.enTask([&started, first]() { started.fetch_add(1); first.wait(); });
+	auto b2 = pool.enTask([&started, second]() { started.fetch_add(1); second.wait(); });
+	while (started.load() < 2)
+		std::this_thread::sleep_for(1ms);
+
+	// a long task with a deep queue behind it
+	std::atomic<bool> long_started { false };
+	std::atomic<int> completed { 0 };
+	const int tiny = 30;
+	auto l = pool.enTask([&long_started, long_one]() { long_started = true; long_one.wait(); });
+	for (int i = 0; i < tiny; ++i)
+		pool.enTask([&completed]() { completed.fetch_add(1); });
+
+	// the first worker takes the long task and a batch, then blocks in it
+	gate_first.set_value();
+	while (!long_started.load())
+		std::this_thread::sleep_for(1ms);
+
+	// the parked batch still counts as waiting: queue + batch == tiny saturates
+	CCThreadPool::InlineExecutionConfig config;
+	config.run_inline_when_saturated = true;
+	config.saturation_queue_depth = tiny;
+	pool.set_inline_execution(config);
+	auto saturated = pool.enTask([]() { return std::this_thread::get_id(); });
+	ASSERT_TRUE(saturated.wait_for(0s) == std::future_status::ready, "batched backlog saturates");
+	ASSERT_TRUE(saturated.get() == std::this_thread::get_id(), "saturated task runs on the caller");
+
+	// the second worker must finish everything, including that batch
+	gate_second.set_value();
+	auto deadline = std::chrono::steady_clock::now() + 5s;
+	while (completed.load() < tiny && std::chrono::steady_clock::now() < deadline)
+		std::this_thread::sleep_for(1ms);
+	ASSERT_EQ(completed.load(), tiny, "no task stranded behind the long one");
+
+	gate_long.set_value();
+	b1.get();
+	b2.get();
+	l.get();
+
+	std::cout << "batch_stealing passed\n";
+}
+
 // 5) resize under load: increase and decrease threads while tasks exist
 void test_resize_behavior() {
 	banner("resize_behavior");
@@ -242,6 +556,59 @@ void test_resize_behavior() {
 	std::cout << "resize_behavior passed\n";
 }
 
+// 6) lock profile: counters only move when built with CCTHREADPOOL_PROFILE_LOCKS
+void test_lock_profile() {
+	banner("lock_profile");
+	CCThreadPool::CCThreadPool pool(std::make_unique<CCThreadPool::ThreadCountDefaultProvider>());
+
+	std::vector<std::future<int>> futures;
+	for (int i = 0; i < 1000; ++i)
+		futures.emplace_back(pool.enTask([i]() { return i; }));
+	for (auto& f : futures)
+		(void)f.get();
+	// one at a time with pauses, so the workers sleep and get woken up
+	for (int i = 0; i < 20; ++i) {
+		std::this_thread::sleep_for(1ms);
+		pool.enTask([]() { }).get();
+	}
+
+	const auto profile = pool.lock_profile();
+#ifdef CCTHREADPOOL_PROFILE_LOCKS
+	ASSERT_TRUE(profile.enabled, "profile should be enabled");
+	ASSERT_TRUE(profile.tasks_queue_locker.acquire_count >= 1000u,
+	            "every enTask takes the queue locker");
+	ASSERT_TRUE(profile.tasks_queue_locker.contended_count
+	                <= profile.tasks_queue_locker.acquire_count,
+	            "contentions never exceed acquires");
+	ASSERT_TRUE(profile.wakeup_count >= 1u, "sleeping workers are woken up");
+	ASSERT_TRUE(profile.spurious_wakeup_count <= profile.wakeup_count,
+	            "spurious wakeups are part of the wakeups");
+	ASSERT_TRUE(profile.tasks_queue_locker_enTask.acquire_count >= 1000u,
+	            "enTask acquisitions are told apart");
+	ASSERT_TRUE(profile.tasks_queue_locker_worker_func.acquire_count >= 1u,
+	            "worker_func acquisitions are told apart");
+	ASSERT_EQ(profile.tasks_queue_locker_enTask.acquire_count
+	              + profile.tasks_queue_locker_worker_func.acquire_count
+	              + profile.tasks_queue_locker_management.acquire_count,
+	          profile.tasks_queue_locker.acquire_count,
+	          "the sites add up to the locker");
+#else
+	ASSERT_TRUE(!profile.enabled, "profile should be disabled");
+	ASSERT_EQ(profile.tasks_queue_locker.acquire_count, 0u, "no counting when disabled");
+#endif
+	std::cout << profile;
+
+	// the wakeups of the released workers survive the shutdown
+	pool.shutdown_all();
+	const auto after = pool.lock_profile();
+	ASSERT_TRUE(after.wakeup_count >= profile.wakeup_count, "wakeups kept after shutdown");
+	ASSERT_TRUE(after.spurious_wakeup_count >= profile.spurious_wakeup_count, "spurious wakeups kept after shutdown");
+	ASSERT_TRUE(after.tasks_queue_locker.acquire_count >= profile.tasks_queue_locker.acquire_count,
+	            "locker counts kept after shutdown");
+
+	std::cout << "lock_profile passed\n";
+}
+
 // ---------- main ----------
 int main(int argc, char** argv) {
 	try {
@@ -280,6 +647,41 @@ int main(int argc, char** argv) {
 		return 5;
 	}
 
+	try {
+		test_policy_pool();
+	} catch (...) {
+		std::cerr << "policy_pool failed\n";
+		return 8;
+	}
+
+	try {
+		test_inline_execution();
+	} catch (...) {
+		std::cerr << "inline_execution failed\n";
+		return 9;
+	}
+
+	try {
+		test_parallel_algorithms();
+	} catch (...) {
+		std::cerr << "parallel_algorithms failed\n";
+		return 10;
+	}
+
+	try {
+		test_batch_stealing();
+	} catch (...) {
+		std::cerr << "batch_stealing failed\n";
+		return 11;
+	}
+
+	try {
+		test_lock_profile();
+	} catch (...) {
+		std::cerr << "lock_profile failed\n";
+		return 6;
+	}
+
 	std::cout << "\nALL TESTS PASSED\n";
 	return 0;
 }